@@ -326,6 +326,14 @@ public:
      * @return the index of the particle that was added
      */
     int addParticle(double charge, double sigma, double epsilon);
+    /**
+     * Reserve storage for particles.  Calling this before adding a large number of
+     * particles with addParticle() avoids repeated reallocation of internal arrays.
+     * It does not change the number of particles in the force.
+     *
+     * @param count   the number of particles to reserve storage for
+     */
+    void reserveParticles(int count);
     /**
      * Get the nonbonded force parameters for a particle.
      *
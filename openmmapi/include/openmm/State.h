@@ -72,10 +72,24 @@ public:
      * Get the position of each particle.  If this State does not contain positions, this will throw an exception.
      */
     const std::vector<Vec3>& getPositions() const;
+    /**
+     * Get a pointer to the position of each particle as a flat array of doubles, ordered
+     * x1, y1, z1, x2, y2, z2, ...  This refers to the same data returned by getPositions()
+     * without copying it, which can be useful in performance sensitive code.  If this State
+     * does not contain positions, this will throw an exception.
+     */
+    const double* getPositionData() const;
     /**
      * Get the velocity of each particle.  If this State does not contain velocities, this will throw an exception.
      */
     const std::vector<Vec3>& getVelocities() const;
+    /**
+     * Get a pointer to the velocity of each particle as a flat array of doubles, ordered
+     * x1, y1, z1, x2, y2, z2, ...  This refers to the same data returned by getVelocities()
+     * without copying it, which can be useful in performance sensitive code.  If this State
+     * does not contain velocities, this will throw an exception.
+     */
+    const double* getVelocityData() const;
     /**
      * Get the force acting on each particle.  If this State does not contain forces, this will throw an exception.
      */
@@ -89,6 +89,16 @@ public:
         masses.push_back(mass);
         return masses.size()-1;
     }
+    /**
+     * Reserve storage for particles.  Calling this before adding a large number of
+     * particles with addParticle() avoids repeated reallocation of internal arrays.
+     * It does not change the number of particles in the System.
+     *
+     * @param count   the number of particles to reserve storage for
+     */
+    void reserveParticles(int count) {
+        masses.reserve(count);
+    }
     /**
      * Get the mass (in atomic mass units) of a particle.  If the mass is 0, Integrators will ignore
      * the particle and not modify its position or velocity.  This is most often
@@ -149,6 +159,14 @@ public:
      * @return the index of the constraint that was added
      */
     int addConstraint(int particle1, int particle2, double distance);
+    /**
+     * Reserve storage for constraints.  Calling this before adding a large number of
+     * constraints with addConstraint() avoids repeated reallocation of internal arrays.
+     * It does not change the number of constraints in the System.
+     *
+     * @param count   the number of constraints to reserve storage for
+     */
+    void reserveConstraints(int count);
     /**
      * Get the parameters defining a distance constraint.
      *
@@ -143,6 +143,10 @@ int NonbondedForce::addParticle(double charge, double sigma, double epsilon) {
     return particles.size()-1;
 }
 
+void NonbondedForce::reserveParticles(int count) {
+    particles.reserve(count);
+}
+
 void NonbondedForce::getParticleParameters(int index, double& charge, double& sigma, double& epsilon) const {
     ASSERT_VALID_INDEX(index, particles);
     charge = particles[index].charge;
@@ -43,11 +43,21 @@ const vector<Vec3>& State::getPositions() const {
         throw OpenMMException("Invoked getPositions() on a State which does not contain positions.");
     return positions;
 }
+const double* State::getPositionData() const {
+    if ((types&Positions) == 0)
+        throw OpenMMException("Invoked getPositionData() on a State which does not contain positions.");
+    return reinterpret_cast<const double*>(positions.data());
+}
 const vector<Vec3>& State::getVelocities() const {
     if ((types&Velocities) == 0)
         throw OpenMMException("Invoked getVelocities() on a State which does not contain velocities.");
     return velocities;
 }
+const double* State::getVelocityData() const {
+    if ((types&Velocities) == 0)
+        throw OpenMMException("Invoked getVelocityData() on a State which does not contain velocities.");
+    return reinterpret_cast<const double*>(velocities.data());
+}
 const vector<Vec3>& State::getForces() const {
     if ((types&Forces) == 0)
         throw OpenMMException("Invoked getForces() on a State which does not contain forces.");
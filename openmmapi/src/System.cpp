@@ -80,6 +80,10 @@ int System::addConstraint(int particle1, int particle2, double distance) {
     return constraints.size()-1;
 }
 
+void System::reserveConstraints(int count) {
+    constraints.reserve(count);
+}
+
 void System::getConstraintParameters(int index, int& particle1, int& particle2, double& distance) const {
     ASSERT_VALID_INDEX(index, constraints);
     particle1 = constraints[index].particle1;
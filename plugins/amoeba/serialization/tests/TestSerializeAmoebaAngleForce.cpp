@@ -33,8 +33,10 @@
 #include "openmm/internal/AssertionUtilities.h"
 #include "openmm/AmoebaAngleForce.h"
 #include "openmm/serialization/XmlSerializer.h"
+#include <cstring>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 using namespace OpenMM;
 using namespace std;
@@ -71,17 +73,19 @@ void testSerialization() {
     ASSERT_EQUAL(force1.getAmoebaGlobalAnglePentic(),  force2.getAmoebaGlobalAnglePentic());
     ASSERT_EQUAL(force1.getAmoebaGlobalAngleSextic(),  force2.getAmoebaGlobalAngleSextic());
     ASSERT_EQUAL(force1.getNumAngles(),                        force2.getNumAngles());
-    for (unsigned int ii = 0; ii < static_cast<unsigned int>(force1.getNumAngles()); ii++) {
-        int a1, a2, a3, b1, b2, b3;
-        double da, db, ka, kb;
-        force1.getAngleParameters(ii, a1, a2, a3, da, ka);
-        force2.getAngleParameters(ii, b1, b2, b3, db, kb);
-        ASSERT_EQUAL(a1, b1);
-        ASSERT_EQUAL(a2, b2);
-        ASSERT_EQUAL(a3, b3);
-        ASSERT_EQUAL(da, db);
-        ASSERT_EQUAL(ka, kb);
+
+    // Gather the angle tables of both forces into flat arrays and compare them
+    // in bulk, rather than asserting on each field of each angle separately.
+
+    int numAngles = force1.getNumAngles();
+    vector<int> particles1(3*numAngles), particles2(3*numAngles);
+    vector<double> params1(2*numAngles), params2(2*numAngles);
+    for (int ii = 0; ii < numAngles; ii++) {
+        force1.getAngleParameters(ii, particles1[3*ii], particles1[3*ii+1], particles1[3*ii+2], params1[2*ii], params1[2*ii+1]);
+        force2.getAngleParameters(ii, particles2[3*ii], particles2[3*ii+1], particles2[3*ii+2], params2[2*ii], params2[2*ii+1]);
     }
+    ASSERT(memcmp(&particles1[0], &particles2[0], 3*numAngles*sizeof(int)) == 0);
+    ASSERT(memcmp(&params1[0], &params2[0], 2*numAngles*sizeof(double)) == 0);
 }
 
 int main() {
@@ -37,6 +37,7 @@
 #include "openmm/OpenMMException.h"
 #include "openmm/internal/windowsExport.h"
 #include <iosfwd>
+#include <string>
 
 namespace OpenMM {
 
@@ -90,7 +91,7 @@ private:
     class StreamReader;
     static void serialize(const SerializationNode& node, std::ostream& stream);
     static void* deserializeStream(std::istream& stream);
-    static void encodeNode(const SerializationNode& node, std::ostream& stream, int depth);
+    static void encodeNode(const SerializationNode& node, std::string& buffer, int depth);
 };
 
 } // namespace OpenMM
@@ -31,7 +31,8 @@
 
 #include "openmm/serialization/SerializationNode.h"
 #include "openmm/OpenMMException.h"
-#include <sstream>
+#include <cstdio>
+#include <cstdlib>
 
 using namespace OpenMM;
 using namespace std;
@@ -100,24 +101,20 @@ int SerializationNode::getIntProperty(const string& name) const {
     map<string, string>::const_iterator iter = properties.find(name);
     if (iter == properties.end())
         throw OpenMMException("Unknown property '"+name+"' in node '"+getName()+"'");
-    int value;
-    stringstream(iter->second) >> value;
-    return value;
+    return (int) strtol(iter->second.c_str(), NULL, 10);
 }
 
 int SerializationNode::getIntProperty(const string& name, int defaultValue) const {
     map<string, string>::const_iterator iter = properties.find(name);
     if (iter == properties.end())
         return defaultValue;
-    int value;
-    stringstream(iter->second) >> value;
-    return value;
+    return (int) strtol(iter->second.c_str(), NULL, 10);
 }
 
 SerializationNode& SerializationNode::setIntProperty(const string& name, int value) {
-    stringstream s;
-    s << value;
-    properties[name] = s.str();
+    char buffer[32];
+    sprintf(buffer, "%d", value);
+    properties[name] = string(buffer);
     return *this;
 }
 
@@ -126,24 +123,18 @@ bool SerializationNode::getBoolProperty(const string& name) const {
     map<string, string>::const_iterator iter = properties.find(name);
     if (iter == properties.end())
         throw OpenMMException("Unknown property '"+name+"' in node '"+getName()+"'");
-    bool value;
-    stringstream(iter->second) >> value;
-    return value;
+    return strtol(iter->second.c_str(), NULL, 10) != 0;
 }
 
 bool SerializationNode::getBoolProperty(const string& name, bool defaultValue) const {
     map<string, string>::const_iterator iter = properties.find(name);
     if (iter == properties.end())
         return defaultValue;
-    bool value;
-    stringstream(iter->second) >> value;
-    return value;
+    return strtol(iter->second.c_str(), NULL, 10) != 0;
 }
 
 SerializationNode& SerializationNode::setBoolProperty(const string& name, bool value) {
-    stringstream s;
-    s << value;
-    properties[name] = s.str();
+    properties[name] = (value ? "1" : "0");
     return *this;
 }
 
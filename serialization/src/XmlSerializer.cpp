@@ -57,6 +57,7 @@ static void encodeString(const string& str, string* outString) {
 
     int i=0;
 
+    outString->reserve(outString->size()+str.length());
     while (i<(int)str.length()) {
         unsigned char c = (unsigned char) str[i];
 
@@ -107,30 +108,43 @@ static void encodeString(const string& str, string* outString) {
 }
 
 void XmlSerializer::serialize(const SerializationNode& node, std::ostream& stream) {
-    stream << "<?xml version=\"1.0\" ?>\n";
-    encodeNode(node, stream, 0);
+    // Build the document in an in-memory buffer and emit it with a single
+    // write, rather than pushing each token through the stream separately.
+
+    string buffer;
+    buffer.reserve(16384);
+    buffer += "<?xml version=\"1.0\" ?>\n";
+    encodeNode(node, buffer, 0);
+    stream.write(buffer.data(), buffer.size());
 }
 
-void XmlSerializer::encodeNode(const SerializationNode& node, std::ostream& stream, int depth) {
-    for (int i = 0; i < depth; i++)
-        stream << '\t';
-    stream << '<' << node.getName();
+void XmlSerializer::encodeNode(const SerializationNode& node, std::string& buffer, int depth) {
+    buffer.append(depth, '\t');
+    buffer += '<';
+    buffer += node.getName();
+    string name, value;
     for (auto& prop : node.getProperties()) {
-        string name, value;
+        name.clear();
+        value.clear();
         encodeString(prop.first, &name);
         encodeString(prop.second, &value);
-        stream << ' ' << name << "=\"" << value << '\"';
+        buffer += ' ';
+        buffer += name;
+        buffer += "=\"";
+        buffer += value;
+        buffer += '\"';
     }
     const vector<SerializationNode>& children = node.getChildren();
     if (children.size() == 0)
-        stream << "/>\n";
+        buffer += "/>\n";
     else {
-        stream << ">\n";
+        buffer += ">\n";
         for (auto& child : children)
-            encodeNode(child, stream, depth+1);
-        for (int i = 0; i < depth; i++)
-            stream << '\t';
-        stream << "</" << node.getName() << ">\n";
+            encodeNode(child, buffer, depth+1);
+        buffer.append(depth, '\t');
+        buffer += "</";
+        buffer += node.getName();
+        buffer += ">\n";
     }
 }
 
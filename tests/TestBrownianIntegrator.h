@@ -148,12 +148,15 @@ void testConstraints() {
 
     // Simulate it and see whether the constraints remain satisfied.
 
+    vector<int> cp1(numConstraints), cp2(numConstraints);
+    vector<double> cd0(numConstraints);
+    for (int j = 0; j < numConstraints; ++j)
+        system.getConstraintParameters(j, cp1[j], cp2[j], cd0[j]);
     for (int i = 0; i < 1000; ++i) {
         State state = context.getState(State::Positions);
         for (int j = 0; j < numConstraints; ++j) {
-            int particle1, particle2;
-            double distance;
-            system.getConstraintParameters(j, particle1, particle2, distance);
+            int particle1 = cp1[j], particle2 = cp2[j];
+            double distance = cd0[j];
             Vec3 p1 = state.getPositions()[particle1];
             Vec3 p2 = state.getPositions()[particle2];
             double dist = std::sqrt((p1[0]-p2[0])*(p1[0]-p2[0])+(p1[1]-p2[1])*(p1[1]-p2[1])+(p1[2]-p2[2])*(p1[2]-p2[2]));